@@ -3,35 +3,45 @@
 #include <vector>
 #include <limits>
 #include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include "workspace.hpp"
 using namespace std;
 
 namespace Assignment {
 
 const int INF = numeric_limits<int>::max();
-int hungarian(vector<vector<int>>& cost, vector<pair<int, int>>& assignments) {
-    int n = cost.size();
-    int m = cost[0].size();
-    int size = max(n, m);
 
-    // Make the cost matrix square by padding with zeros
-    vector<vector<int>> square_cost(size, vector<int>(size, 0));
-    for (int i = 0; i < n; i++)
-        for (int j = 0; j < m; j++)
-            square_cost[i][j] = cost[i][j];
+// Headroom for c - u[i] - v[j] in hungarianCore: callers taking untrusted
+// input should keep max(n, m) * |cost| within this.
+const int MAX_COST = INF / 4;
+
+// Hungarian algorithm over a flat row-major n x m cost buffer;
+// cells outside it are the zero padding. Size is int for runtime shapes or an
+// integral_constant when the square size is known at compile time, so the
+// loops below get constant trip counts. Scratch arrays hold size + 1 entries.
+template <typename Size>
+int hungarianCore(const int* cost, int n, int m, Size size,
+                  int* u, int* v, int* p, int* way, int* minv, bool* used) {
+    for (int j = 0; j <= size; j++) u[j] = v[j] = p[j] = way[j] = 0;
 
-    vector<int> u(size + 1), v(size + 1), p(size + 1), way(size + 1);
     for (int i = 1; i <= size; i++) {
         p[0] = i;
         int j0 = 0;
-        vector<int> minv(size + 1, INF);
-        vector<bool> used(size + 1, false);
+        for (int j = 0; j <= size; j++) {
+            minv[j] = INF;
+            used[j] = false;
+        }
 
         do {
             used[j0] = true;
             int i0 = p[j0], delta = INF, j1 = -1;
             for (int j = 1; j <= size; j++) {
                 if (!used[j]) {
-                    int cur = square_cost[i0 - 1][j - 1] - u[i0] - v[j];
+                    int c = (i0 <= n && j <= m) ? cost[(i0 - 1) * m + (j - 1)] : 0;
+                    int cur = c - u[i0] - v[j];
                     if (cur < minv[j]) {
                         minv[j] = cur;
                         way[j] = j0;
@@ -63,17 +73,109 @@ int hungarian(vector<vector<int>>& cost, vector<pair<int, int>>& assignments) {
         } while (j0);
     }
 
-    // Extract assignment: p[j] = i means i is assigned to j
-    assignments.clear();
+    return -v[0];
+}
+
+// taskOf[i] receives the task assigned to worker i, or -1 if the worker was
+// matched to a padding column.
+void extractTasks(const int* p, int n, int m, int* taskOf) {
+    for (int i = 0; i < n; i++) taskOf[i] = -1;
     for (int j = 1; j <= m; j++) {
-        int i = p[j];
-        if (i <= n) {
-            assignments.emplace_back(i - 1, j - 1); // i-th worker → j-th task
-        }
+        if (p[j] <= n) taskOf[p[j] - 1] = j - 1;
+    }
+}
+
+// hungarianCore with all scratch taken from the arena.
+int hungarian(const int* cost, int n, int m, Workspace::Arena& arena, int* taskOf) {
+    int size = max(n, m);
+    int* u = arena.alloc<int>(size + 1);
+    int* v = arena.alloc<int>(size + 1);
+    int* p = arena.alloc<int>(size + 1);
+    int* way = arena.alloc<int>(size + 1);
+    int* minv = arena.alloc<int>(size + 1);
+    bool* used = arena.alloc<bool>(size + 1);
+
+    int result = hungarianCore(cost, n, m, size, u, v, p, way, minv, used);
+    extractTasks(p, n, m, taskOf);
+    return result;
+}
+
+// hungarianCore for max(n, m) == N, with std::array storage and the padded
+// square cost copied in so the inner loop has no bounds checks.
+template <int N>
+int hungarianFixed(const int* cost, int n, int m, int* taskOf) {
+    array<int, N * N> square{};
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < m; j++)
+            square[i * N + j] = cost[i * m + j];
+
+    array<int, N + 1> u, v, p, way, minv;
+    array<bool, N + 1> used;
+    int result = hungarianCore(square.data(), N, N, integral_constant<int, N>{},
+                               u.data(), v.data(), p.data(), way.data(), minv.data(), used.data());
+    extractTasks(p.data(), n, m, taskOf);
+    return result;
+}
+
+const int MAX_FIXED_SIZE = 16;
+
+using FixedKernel = int (*)(const int*, int, int, int*);
+
+template <int... Sizes>
+constexpr array<FixedKernel, sizeof...(Sizes)> makeFixedKernels(integer_sequence<int, Sizes...>) {
+    return { &hungarianFixed<Sizes + 1>... };
+}
+
+// fixedKernels[k] solves problems whose padded size is k + 1
+constexpr array<FixedKernel, MAX_FIXED_SIZE> fixedKernels =
+    makeFixedKernels(make_integer_sequence<int, MAX_FIXED_SIZE>{});
+
+// Entry point for batch callers: problems up to 16 x 16 go to the
+// compile-time sized kernels, larger ones to the arena-backed version.
+int solve(const int* cost, int n, int m, Workspace::Arena& arena, int* taskOf) {
+    int size = max(n, m);
+    if (size <= MAX_FIXED_SIZE) return fixedKernels[size - 1](cost, n, m, taskOf);
+    return hungarian(cost, n, m, arena, taskOf);
+}
+
+int hungarian(vector<vector<int>>& cost, vector<pair<int, int>>& assignments) {
+    int n = cost.size();
+    int m = cost[0].size();
+    int size = max(n, m);
+
+    vector<int> taskOf(n);
+    int result;
+    if (size <= MAX_FIXED_SIZE) {
+        array<int, MAX_FIXED_SIZE * MAX_FIXED_SIZE> flat{};
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < m; j++)
+                flat[i * m + j] = cost[i][j];
+        result = fixedKernels[size - 1](flat.data(), n, m, taskOf.data());
+    } else {
+        vector<int> flat(n * m);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < m; j++)
+                flat[i * m + j] = cost[i][j];
+
+        vector<int> u(size + 1), v(size + 1), p(size + 1), way(size + 1), minv(size + 1);
+        unique_ptr<bool[]> used(new bool[size + 1]);
+        result = hungarianCore(flat.data(), n, m, size, u.data(), v.data(), p.data(),
+                               way.data(), minv.data(), used.get());
+        extractTasks(p.data(), n, m, taskOf.data());
     }
 
-    return -v[0]; // optimal cost
-}void runAssignment() {
+    // Extract assignment in task order: i-th worker → j-th task
+    vector<int> workerOf(m, -1);
+    for (int i = 0; i < n; i++)
+        if (taskOf[i] >= 0) workerOf[taskOf[i]] = i;
+    assignments.clear();
+    for (int j = 0; j < m; j++)
+        if (workerOf[j] >= 0) assignments.emplace_back(workerOf[j], j);
+
+    return result; // optimal cost
+}
+
+void runAssignment() {
     int n, m;
     cout << "Enter number of workers: ";
     cin >> n;
@@ -3,6 +3,7 @@
 #include "dual_simplex.hpp"
 #include "assignment.hpp"
 #include "transportation.hpp"
+#include "server.hpp"
 
 using namespace std;
 
@@ -16,7 +17,11 @@ void displayMenu() {
     cout << "Enter your choice (1-5): ";
 }
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1 && string(argv[1]) == "--server") {
+        return Server::run(argc, argv);
+    }
+
     int choice;
     
     do {
@@ -0,0 +1,264 @@
+#pragma once
+#include <limits>
+#include <cmath>
+#include "simplex.hpp"
+#include "workspace.hpp"
+
+using namespace std;
+
+// Sensitivity ranging and parametric sweeps read off an optimal tableau from
+// Simplex::solve / Simplex::solveTable (max c.x subject to Ax <= b, x >= 0).
+// With m constraints and n variables, slack column n + k of the final tableau
+// is column k of B^-1, and the objective row holds the reduced costs, with the
+// shadow prices under the slack columns.
+namespace Sensitivity {
+
+const double EPS = Simplex::EPS;
+const double INF = numeric_limits<double>::infinity();
+
+struct Range {
+    double lower;
+    double upper;
+};
+
+struct SweepPoint {
+    double value;            // parameter value at this point
+    Simplex::Status status;  // Optimal, Infeasible (RHS) or Unbounded (cost)
+    double objective;        // only meaningful when status is Optimal
+};
+
+bool isBasic(const int* basis, size_t m, size_t col) {
+    for (size_t i = 0; i < m; i++)
+        if (basis[i] == static_cast<int>(col)) return true;
+    return false;
+}
+
+// Shadow price of each constraint, and the ranges of each RHS entry and each
+// objective coefficient over which the current basis stays optimal (one at a
+// time, everything else fixed). rhs and objective are the original b and c.
+// Bounds that do not exist are +/-infinity.
+void analyze(const double* table, size_t rows, size_t cols, const int* basis,
+             const double* rhs, const double* objective,
+             double* shadowPrices, Range* rhsRanges, Range* costRanges) {
+    size_t m = rows - 1, n = cols - rows;
+    const double* z = table + m * cols;
+
+    for (size_t k = 0; k < m; k++) {
+        shadowPrices[k] = z[n + k];
+
+        // x_B + delta * B^-1 e_k >= 0
+        double lo = -INF, hi = INF;
+        for (size_t i = 0; i < m; i++) {
+            double d = table[i * cols + n + k];
+            double x = table[i * cols + cols - 1];
+            if (d > EPS) lo = max(lo, -x / d);
+            else if (d < -EPS) hi = min(hi, -x / d);
+        }
+        rhsRanges[k] = { rhs[k] + lo, rhs[k] + hi };
+    }
+
+    for (size_t j = 0; j < n; j++) {
+        int row = -1;
+        for (size_t i = 0; i < m; i++)
+            if (basis[i] == static_cast<int>(j)) row = static_cast<int>(i);
+
+        if (row == -1) {
+            // Nonbasic: stays out until its reduced cost reaches zero
+            costRanges[j] = { -INF, objective[j] + z[j] };
+            continue;
+        }
+
+        // Basic: every nonbasic reduced cost moves by delta * (row entry)
+        double lo = -INF, hi = INF;
+        const double* r = table + row * cols;
+        for (size_t k = 0; k < cols - 1; k++) {
+            if (isBasic(basis, m, k)) continue;
+            if (r[k] > EPS) lo = max(lo, -z[k] / r[k]);
+            else if (r[k] < -EPS) hi = min(hi, -z[k] / r[k]);
+        }
+        costRanges[j] = { objective[j] + lo, objective[j] + hi };
+    }
+}
+
+double pointValue(double from, double to, size_t points, size_t p) {
+    return points == 1 ? from : from + (to - from) * p / (points - 1);
+}
+
+// Basic solution for the current basis with RHS entry k shifted by delta.
+void rhsSolution(const double* table, size_t m, size_t n, size_t cols, const int* basis,
+                 size_t k, double delta, double* x) {
+    for (size_t j = 0; j < n; j++) x[j] = 0;
+    for (size_t i = 0; i < m; i++) {
+        if (basis[i] < static_cast<int>(n))
+            x[basis[i]] = table[i * cols + cols - 1] + delta * table[i * cols + n + k];
+    }
+}
+
+// Re-solves the LP at `points` evenly spaced values of b[constraint] from
+// `from` to `to`, starting from an optimal tableau for b[constraint] = base.
+// Between breakpoints only the basic values move (along the slack column of
+// the constraint); at each breakpoint the row that reaches zero leaves with a
+// single dual simplex pivot. The pivots run on an arena copy, so table and
+// basis are left as they were. If solutions is not null it receives
+// points x n values. Returns the number of pivots taken.
+size_t sweepRhs(const double* table, size_t rows, size_t cols, const int* basis,
+                size_t constraint, double base, double from, double to, size_t points,
+                Workspace::Arena& arena, SweepPoint* out, double* solutions) {
+    size_t m = rows - 1, n = cols - rows, k = n + constraint;
+    double* t = arena.alloc<double>(rows * cols);
+    for (size_t i = 0; i < rows * cols; i++) t[i] = table[i];
+    int* b = arena.alloc<int>(m);
+    for (size_t i = 0; i < m; i++) b[i] = basis[i];
+    double* z = t + m * cols;
+    double current = 0; // offset from base the basis is known optimal at
+    size_t pivots = 0, maxPivots = 50 * cols;
+
+    for (size_t p = 0; p < points; p++) {
+        double value = pointValue(from, to, points, p);
+        double target = value - base;
+        Simplex::Status status = Simplex::Status::Optimal;
+
+        while (true) {
+            double dir = target >= current ? 1 : -1;
+            int leave = -1;
+            // A breakpoint right at the target still leaves the basis optimal there
+            double hit = target - dir * EPS * (1 + fabs(target));
+            for (size_t i = 0; i < m; i++) {
+                double d = t[i * cols + k];
+                if (dir * d >= -EPS) continue;
+                double at = -t[i * cols + cols - 1] / d;
+                if (dir * at < dir * hit) {
+                    hit = at;
+                    leave = static_cast<int>(i);
+                }
+            }
+            if (leave == -1) break;
+            current = dir > 0 ? max(current, hit) : min(current, hit);
+
+            // Dual ratio test on the leaving row
+            const double* r = t + leave * cols;
+            int enter = -1;
+            double best = INF;
+            for (size_t j = 0; j < cols - 1; j++) {
+                if (r[j] < -EPS) {
+                    double ratio = fabs(z[j] / r[j]);
+                    if (ratio < best) {
+                        best = ratio;
+                        enter = static_cast<int>(j);
+                    }
+                }
+            }
+            if (enter == -1 || pivots == maxPivots) {
+                status = enter == -1 ? Simplex::Status::Infeasible : Simplex::Status::IterationLimit;
+                break;
+            }
+            Simplex::pivot(t, rows, cols, b, leave, enter);
+            pivots++;
+        }
+
+        out[p].value = value;
+        out[p].status = status;
+        if (status != Simplex::Status::Optimal) {
+            out[p].objective = 0;
+            continue;
+        }
+        current = target;
+        out[p].objective = z[cols - 1] + target * z[k];
+        if (solutions) rhsSolution(t, m, n, cols, b, constraint, target, solutions + p * n);
+    }
+    return pivots;
+}
+
+// Re-solves the LP at `points` evenly spaced values of c[variable] from `from`
+// to `to`, starting from an optimal tableau for c[variable] = base. An extra
+// row carried through the pivots holds the derivative of the objective row, so
+// reduced costs are known in closed form between breakpoints; at each
+// breakpoint the column whose reduced cost reaches zero enters with a single
+// primal pivot. As in sweepRhs, the pivots run on an arena copy and table and
+// basis are left as they were.
+size_t sweepCost(const double* table, size_t rows, size_t cols, const int* basis,
+                 size_t variable, double base, double from, double to, size_t points,
+                 Workspace::Arena& arena, SweepPoint* out, double* solutions) {
+    size_t m = rows - 1, n = cols - rows;
+    int* b = arena.alloc<int>(m);
+    for (size_t i = 0; i < m; i++) b[i] = basis[i];
+
+    // Work on the tableau plus the derivative row q, priced out against the basis
+    double* t = arena.alloc<double>((rows + 1) * cols);
+    for (size_t i = 0; i < rows * cols; i++) t[i] = table[i];
+    double* z = t + m * cols;
+    double* q = t + rows * cols;
+    for (size_t j = 0; j < cols; j++) q[j] = 0;
+    q[variable] = -1;
+    for (size_t i = 0; i < m; i++) {
+        if (b[i] == static_cast<int>(variable)) {
+            for (size_t j = 0; j < cols; j++) q[j] += t[i * cols + j];
+        }
+    }
+
+    double current = 0;
+    size_t pivots = 0, maxPivots = 50 * cols;
+
+    for (size_t p = 0; p < points; p++) {
+        double value = pointValue(from, to, points, p);
+        double target = value - base;
+        Simplex::Status status = Simplex::Status::Optimal;
+
+        while (true) {
+            double dir = target >= current ? 1 : -1;
+            int enter = -1;
+            // A breakpoint right at the target still leaves the basis optimal there
+            double hit = target - dir * EPS * (1 + fabs(target));
+            for (size_t j = 0; j < cols - 1; j++) {
+                if (dir * q[j] >= -EPS) continue;
+                double at = -z[j] / q[j];
+                if (dir * at < dir * hit) {
+                    hit = at;
+                    enter = static_cast<int>(j);
+                }
+            }
+            if (enter == -1) break;
+            current = dir > 0 ? max(current, hit) : min(current, hit);
+
+            // Primal ratio test on the entering column
+            int leave = -1;
+            double best = INF;
+            for (size_t i = 0; i < m; i++) {
+                double a = t[i * cols + enter];
+                if (a > EPS) {
+                    double ratio = t[i * cols + cols - 1] / a;
+                    if (ratio < best) {
+                        best = ratio;
+                        leave = static_cast<int>(i);
+                    }
+                }
+            }
+            if (leave == -1 || pivots == maxPivots) {
+                status = leave == -1 ? Simplex::Status::Unbounded : Simplex::Status::IterationLimit;
+                break;
+            }
+            // Pivoting z and q separately is the same as pivoting z + delta * q
+            Simplex::pivot(t, rows + 1, cols, b, leave, enter);
+            pivots++;
+        }
+
+        out[p].value = value;
+        out[p].status = status;
+        if (status != Simplex::Status::Optimal) {
+            out[p].objective = 0;
+            continue;
+        }
+        current = target;
+        out[p].objective = z[cols - 1] + target * q[cols - 1];
+        if (solutions) {
+            double* x = solutions + p * n;
+            for (size_t j = 0; j < n; j++) x[j] = 0;
+            for (size_t i = 0; i < m; i++)
+                if (b[i] < static_cast<int>(n)) x[b[i]] = t[i * cols + cols - 1];
+        }
+    }
+
+    return pivots;
+}
+
+}
@@ -0,0 +1,585 @@
+#pragma once
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <cstdarg>
+#include <cctype>
+#include <cmath>
+#include <csignal>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include "workspace.hpp"
+#include "simplex.hpp"
+#include "assignment.hpp"
+#include "transportation.hpp"
+#include "sensitivity.hpp"
+
+using namespace std;
+
+// Long-running solver service. Requests are whitespace-separated text frames,
+// each starting with a keyword and the problem dimensions:
+//
+//   SIMPLEX m n      m rows of (n coefficients, RHS), then n objective coefficients
+//   SENSITIVITY m n  same body; shadow prices, RHS ranges and cost ranges
+//   SWEEP m n        same body, then RHS|COST index from to points
+//   ASSIGN n m       n x m integer cost matrix, row by row
+//   TRANSPORT m n    m supplies, n demands, then the m x n cost matrix
+//   STATS            latency percentiles across all workers
+//   QUIT             close the stream
+//
+// Every request is answered with a single line starting with OK or ERR.
+// A malformed frame gets an ERR and closes the stream, since the reader can
+// no longer tell where the next frame starts.
+namespace Server {
+
+const size_t MAX_DIM = 2048;
+const size_t MAX_CELLS = size_t(1) << 24;
+
+// Buffered tokenizer over a file descriptor; no allocation after construction.
+class FrameReader {
+public:
+    explicit FrameReader(int fd = -1) : fd(fd) {}
+
+    void attach(int newFd) {
+        fd = newFd;
+        pos = len = 0;
+    }
+
+    // Reads the next whitespace-separated token; false at end of input.
+    // overflow is set if the token did not fit in cap - 1 characters, in which
+    // case out holds only its prefix and the token must be rejected.
+    bool token(char* out, size_t cap, bool& overflow) {
+        int c;
+        do {
+            c = next();
+            if (c < 0) return false;
+        } while (isspace(c));
+
+        size_t len = 0;
+        overflow = false;
+        while (c >= 0 && !isspace(c)) {
+            if (len + 1 < cap) out[len++] = static_cast<char>(c);
+            else overflow = true;
+            c = next();
+        }
+        out[len] = '\0';
+        return true;
+    }
+
+    bool number(double& value) {
+        char buf[64];
+        bool overflow;
+        if (!token(buf, sizeof(buf), overflow) || overflow) return false;
+        char* end;
+        value = strtod(buf, &end);
+        // nan and inf parse, but no solver terminates sensibly on them
+        return *end == '\0' && end != buf && isfinite(value);
+    }
+
+    bool integer(long& value) {
+        char buf[32];
+        bool overflow;
+        if (!token(buf, sizeof(buf), overflow) || overflow) return false;
+        char* end;
+        value = strtol(buf, &end, 10);
+        return *end == '\0' && end != buf;
+    }
+
+private:
+    int next() {
+        if (pos == len) {
+            ssize_t got = read(fd, buf, sizeof(buf));
+            if (got <= 0) return -1;
+            len = static_cast<size_t>(got);
+            pos = 0;
+        }
+        return static_cast<unsigned char>(buf[pos++]);
+    }
+
+    int fd;
+    char buf[1 << 16];
+    size_t pos = 0;
+    size_t len = 0;
+};
+
+class ResponseWriter {
+public:
+    explicit ResponseWriter(int fd = -1) : fd(fd) {}
+
+    void attach(int newFd) {
+        fd = newFd;
+        len = 0;
+        ok = true;
+    }
+
+    void printf(const char* fmt, ...) __attribute__((format(printf, 2, 3))) {
+        if (len + 128 > sizeof(buf)) flush();
+        va_list args;
+        va_start(args, fmt);
+        int n = vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
+        va_end(args);
+        if (n > 0) len += min(static_cast<size_t>(n), sizeof(buf) - len - 1);
+    }
+
+    bool flush() {
+        size_t off = 0;
+        while (off < len) {
+            ssize_t put = write(fd, buf + off, len - off);
+            if (put <= 0) {
+                ok = false;
+                break;
+            }
+            off += static_cast<size_t>(put);
+        }
+        len = 0;
+        return ok;
+    }
+
+    bool good() const { return ok; }
+
+private:
+    int fd;
+    char buf[1 << 16];
+    size_t len = 0;
+    bool ok = true;
+};
+
+// Ring of the most recent request latencies, with preallocated scratch so
+// reporting percentiles does not allocate either. One log is shared by every
+// worker, so all members lock.
+class LatencyLog {
+public:
+    explicit LatencyLog(size_t capacity = 1 << 16)
+        : samples(capacity), scratch(capacity) {}
+
+    void record(uint64_t ns) {
+        lock_guard<mutex> lock(guard);
+        samples[total % samples.size()] = ns;
+        total++;
+    }
+
+    // p in [0, 100]; returns nanoseconds
+    uint64_t percentile(double p) {
+        lock_guard<mutex> lock(guard);
+        size_t n = min(total, samples.size());
+        if (n == 0) return 0;
+        copy(samples.begin(), samples.begin() + n, scratch.begin());
+        size_t k = min(n - 1, static_cast<size_t>(p / 100.0 * n));
+        nth_element(scratch.begin(), scratch.begin() + k, scratch.begin() + n);
+        return scratch[k];
+    }
+
+    size_t requests() {
+        lock_guard<mutex> lock(guard);
+        return total;
+    }
+
+private:
+    mutex guard;
+    vector<uint64_t> samples;
+    vector<uint64_t> scratch;
+    size_t total = 0;
+};
+
+class Worker {
+public:
+    explicit Worker(LatencyLog& latencies) : latencies(latencies) {}
+
+    // Serves frames from inFd until EOF, QUIT or a malformed frame.
+    void serve(int inFd, int outFd) {
+        in.attach(inFd);
+        out.attach(outFd);
+        char keyword[32];
+        bool overflow;
+
+        while (out.good() && in.token(keyword, sizeof(keyword), overflow)) {
+            auto start = chrono::steady_clock::now();
+            arena.reset();
+
+            bool keepGoing = true;
+            if (overflow) {
+                out.printf("ERR unknown request '%s...'\n", keyword);
+                keepGoing = false;
+            } else if (strcmp(keyword, "SIMPLEX") == 0) {
+                keepGoing = solveSimplex();
+            } else if (strcmp(keyword, "SENSITIVITY") == 0) {
+                keepGoing = solveSensitivity();
+            } else if (strcmp(keyword, "SWEEP") == 0) {
+                keepGoing = solveSweep();
+            } else if (strcmp(keyword, "ASSIGN") == 0) {
+                keepGoing = solveAssignment();
+            } else if (strcmp(keyword, "TRANSPORT") == 0) {
+                keepGoing = solveTransportation();
+            } else if (strcmp(keyword, "STATS") == 0) {
+                writeStats(out);
+                out.flush();
+                continue;
+            } else if (strcmp(keyword, "QUIT") == 0) {
+                break;
+            } else {
+                out.printf("ERR unknown request '%s'\n", keyword);
+                keepGoing = false;
+            }
+
+            out.flush();
+            auto elapsed = chrono::steady_clock::now() - start;
+            latencies.record(chrono::duration_cast<chrono::nanoseconds>(elapsed).count());
+            if (!keepGoing) break;
+        }
+
+        out.flush();
+    }
+
+    // Percentiles cover every worker sharing the log; arena is this worker's.
+    void writeStats(ResponseWriter& out) {
+        out.printf("OK STATS count=%zu p50=%.1fus p90=%.1fus p99=%.1fus p99.9=%.1fus max=%.1fus arena=%zuB\n",
+                   latencies.requests(),
+                   latencies.percentile(50) / 1e3, latencies.percentile(90) / 1e3,
+                   latencies.percentile(99) / 1e3, latencies.percentile(99.9) / 1e3,
+                   latencies.percentile(100) / 1e3, arena.bytesReserved());
+    }
+
+private:
+    bool readDims(size_t& a, size_t& b) {
+        long x, y;
+        if (!in.integer(x) || !in.integer(y) || x <= 0 || y <= 0 ||
+            static_cast<size_t>(x) > MAX_DIM || static_cast<size_t>(y) > MAX_DIM ||
+            static_cast<size_t>(x) * static_cast<size_t>(y) > MAX_CELLS) {
+            out.printf("ERR bad dimensions\n");
+            return false;
+        }
+        a = static_cast<size_t>(x);
+        b = static_cast<size_t>(y);
+        return true;
+    }
+
+    bool truncated() {
+        out.printf("ERR truncated or non-numeric frame\n");
+        return false;
+    }
+
+    // Reads the body of a SIMPLEX-style frame into a fresh tableau, keeping
+    // copies of the original b and c for sensitivity requests.
+    struct LinearProgram {
+        size_t m, n, rows, cols;
+        double* table;
+        double* rhs;
+        double* objective;
+        int* basis;
+    };
+
+    bool readLinearProgram(LinearProgram& lp) {
+        size_t m, n;
+        if (!readDims(m, n)) return false;
+
+        size_t rows = m + 1, cols = n + m + 1;
+        double* table = arena.allocFilled<double>(rows * cols, 0.0);
+        double* rhs = arena.alloc<double>(m);
+        double* objective = arena.alloc<double>(n);
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (!in.number(table[i * cols + j])) return truncated();
+            }
+            table[i * cols + n + i] = 1; // Slack
+            if (!in.number(rhs[i])) return truncated();
+            table[i * cols + cols - 1] = rhs[i];
+        }
+        for (size_t j = 0; j < n; j++) {
+            if (!in.number(objective[j])) return truncated();
+            table[m * cols + j] = -objective[j]; // Standard form
+        }
+
+        lp = { m, n, rows, cols, table, rhs, objective, arena.alloc<int>(m) };
+        return true;
+    }
+
+    // Answers non-optimal outcomes; returns true if the LP was solved to optimality.
+    bool reportStatus(Simplex::Status status) {
+        switch (status) {
+            case Simplex::Status::Optimal:
+                return true;
+            case Simplex::Status::Unbounded:
+                out.printf("OK UNBOUNDED\n");
+                break;
+            case Simplex::Status::Infeasible:
+                out.printf("OK INFEASIBLE\n");
+                break;
+            case Simplex::Status::IterationLimit:
+                out.printf("OK ITERATION_LIMIT\n");
+                break;
+        }
+        return false;
+    }
+
+    bool solveSimplex() {
+        LinearProgram lp;
+        if (!readLinearProgram(lp)) return false;
+        if (!reportStatus(Simplex::solve(lp.table, lp.rows, lp.cols, lp.basis))) return true;
+
+        out.printf("OK OPTIMAL %.10g", lp.table[lp.rows * lp.cols - 1]);
+        for (size_t j = 0; j < lp.n; j++)
+            out.printf(" %.10g", Simplex::basicValue(lp.table, lp.rows, lp.cols, lp.basis, static_cast<int>(j)));
+        out.printf("\n");
+        return true;
+    }
+
+    bool solveSensitivity() {
+        LinearProgram lp;
+        if (!readLinearProgram(lp)) return false;
+        if (!reportStatus(Simplex::solve(lp.table, lp.rows, lp.cols, lp.basis))) return true;
+
+        double* shadow = arena.alloc<double>(lp.m);
+        Sensitivity::Range* rhsRanges = arena.alloc<Sensitivity::Range>(lp.m);
+        Sensitivity::Range* costRanges = arena.alloc<Sensitivity::Range>(lp.n);
+        Sensitivity::analyze(lp.table, lp.rows, lp.cols, lp.basis, lp.rhs, lp.objective,
+                             shadow, rhsRanges, costRanges);
+
+        out.printf("OK OPTIMAL %.10g shadow", lp.table[lp.rows * lp.cols - 1]);
+        for (size_t k = 0; k < lp.m; k++) out.printf(" %.10g", shadow[k]);
+        out.printf(" rhs");
+        for (size_t k = 0; k < lp.m; k++) out.printf(" %.10g:%.10g", rhsRanges[k].lower, rhsRanges[k].upper);
+        out.printf(" cost");
+        for (size_t j = 0; j < lp.n; j++) out.printf(" %.10g:%.10g", costRanges[j].lower, costRanges[j].upper);
+        out.printf("\n");
+        return true;
+    }
+
+    bool solveSweep() {
+        LinearProgram lp;
+        if (!readLinearProgram(lp)) return false;
+
+        char kind[16];
+        long index, points;
+        double from, to;
+        bool overflow;
+        if (!in.token(kind, sizeof(kind), overflow) || overflow || !in.integer(index) || !in.number(from) ||
+            !in.number(to) || !in.integer(points)) return truncated();
+        bool rhs = strcmp(kind, "RHS") == 0;
+        size_t limit = rhs ? lp.m : lp.n;
+        if ((!rhs && strcmp(kind, "COST") != 0) || index < 1 || static_cast<size_t>(index) > limit ||
+            points < 1 || points > 100000) {
+            out.printf("ERR bad sweep parameters\n");
+            return false;
+        }
+        if (!reportStatus(Simplex::solve(lp.table, lp.rows, lp.cols, lp.basis))) return true;
+
+        size_t k = static_cast<size_t>(index - 1);
+        Sensitivity::SweepPoint* sweep = arena.alloc<Sensitivity::SweepPoint>(points);
+        size_t pivots = rhs
+            ? Sensitivity::sweepRhs(lp.table, lp.rows, lp.cols, lp.basis, k, lp.rhs[k],
+                                    from, to, points, arena, sweep, nullptr)
+            : Sensitivity::sweepCost(lp.table, lp.rows, lp.cols, lp.basis, k, lp.objective[k],
+                                     from, to, points, arena, sweep, nullptr);
+
+        out.printf("OK pivots=%zu", pivots);
+        for (long p = 0; p < points; p++) {
+            switch (sweep[p].status) {
+                case Simplex::Status::Optimal:
+                    out.printf(" %.10g:%.10g", sweep[p].value, sweep[p].objective);
+                    break;
+                case Simplex::Status::Unbounded:
+                    out.printf(" %.10g:UNBOUNDED", sweep[p].value);
+                    break;
+                case Simplex::Status::Infeasible:
+                    out.printf(" %.10g:INFEASIBLE", sweep[p].value);
+                    break;
+                case Simplex::Status::IterationLimit:
+                    out.printf(" %.10g:ITERATION_LIMIT", sweep[p].value);
+                    break;
+            }
+        }
+        out.printf("\n");
+        return true;
+    }
+
+    bool solveAssignment() {
+        size_t n, m;
+        if (!readDims(n, m)) return false;
+
+        // Bound each cost so the potentials and the total stay inside int
+        long limit = Assignment::MAX_COST / static_cast<long>(max(n, m));
+        int* cost = arena.alloc<int>(n * m);
+        for (size_t k = 0; k < n * m; k++) {
+            long c;
+            if (!in.integer(c)) return truncated();
+            if (c < -limit || c > limit) {
+                out.printf("ERR cost out of range (|cost| <= %ld for this size)\n", limit);
+                return false;
+            }
+            cost[k] = static_cast<int>(c);
+        }
+
+        int* taskOf = arena.alloc<int>(n);
+        int result = Assignment::solve(cost, static_cast<int>(n), static_cast<int>(m), arena, taskOf);
+
+        out.printf("OK %d", result);
+        for (size_t i = 0; i < n; i++) out.printf(" %d", taskOf[i] + 1); // 0 = unassigned
+        out.printf("\n");
+        return true;
+    }
+
+    bool solveTransportation() {
+        size_t m, n;
+        if (!readDims(m, n)) return false;
+
+        // One spare row and column for the dummy used to balance the problem
+        size_t rows = m + 1, cols = n + 1;
+        double* supply = arena.alloc<double>(rows);
+        double* demand = arena.alloc<double>(cols);
+        double totalSupply = 0, totalDemand = 0;
+        for (size_t i = 0; i < m; i++) {
+            if (!in.number(supply[i])) return truncated();
+            totalSupply += supply[i];
+        }
+        for (size_t j = 0; j < n; j++) {
+            if (!in.number(demand[j])) return truncated();
+            totalDemand += demand[j];
+        }
+        if (!isfinite(totalSupply) || !isfinite(totalDemand) ||
+            *min_element(supply, supply + m) < 0 || *min_element(demand, demand + n) < 0) {
+            out.printf("ERR supplies and demands must be finite and non-negative\n");
+            return false;
+        }
+
+        if (totalSupply > totalDemand) {
+            demand[n] = totalSupply - totalDemand;
+            rows = m;
+        } else if (totalDemand > totalSupply) {
+            supply[m] = totalDemand - totalSupply;
+            cols = n;
+        } else {
+            rows = m;
+            cols = n;
+        }
+
+        // Dummy cells cost nothing
+        double* cost = arena.allocFilled<double>(rows * cols, 0.0);
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (!in.number(cost[i * cols + j])) return truncated();
+            }
+        }
+
+        double* allocation = arena.alloc<double>(rows * cols);
+        Transportation::vogelApproximation(cost, supply, demand, rows, cols, arena, allocation);
+
+        double total = 0;
+        for (size_t k = 0; k < rows * cols; k++) total += allocation[k] * cost[k];
+
+        out.printf("OK %.10g", total);
+        for (size_t i = 0; i < m; i++) {
+            for (size_t j = 0; j < n; j++) {
+                double q = allocation[i * cols + j];
+                if (q > 0) out.printf(" %zu-%zu:%.10g", i + 1, j + 1, q);
+            }
+        }
+        out.printf("\n");
+        return true;
+    }
+
+    FrameReader in;
+    ResponseWriter out;
+    Workspace::Arena arena;
+    LatencyLog& latencies;
+};
+
+void printStats(Worker& worker) {
+    ResponseWriter err(STDERR_FILENO);
+    worker.writeStats(err);
+    err.flush();
+}
+
+int serveSocket(const char* path, int workers) {
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0) {
+        perror("socket");
+        return 1;
+    }
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        cerr << "Socket path too long: " << path << "\n";
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // Replace a stale socket from an earlier run, but never any other file
+    struct stat existing;
+    if (lstat(path, &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            cerr << "Refusing to replace " << path << ": not a socket\n";
+            return 1;
+        }
+        unlink(path);
+    }
+    if (bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 ||
+        listen(listener, 64) < 0) {
+        perror(path);
+        return 1;
+    }
+    cerr << "Listening on " << path << " with " << workers << " worker(s)\n";
+
+    // Workers share the listening socket and the latency log; each keeps its
+    // own arena for the lifetime of the process.
+    LatencyLog latencies;
+    vector<thread> pool;
+    for (int w = 0; w < workers; w++) {
+        pool.emplace_back([listener, &latencies]() {
+            Worker worker(latencies);
+            while (true) {
+                int conn = accept(listener, nullptr, nullptr);
+                if (conn < 0) {
+                    if (errno == EINTR || errno == ECONNABORTED) continue;
+                    // e.g. EMFILE: log and back off instead of spinning
+                    perror("accept");
+                    this_thread::sleep_for(chrono::milliseconds(100));
+                    continue;
+                }
+                worker.serve(conn, conn);
+                close(conn);
+            }
+        });
+    }
+    for (auto& t : pool) t.join();
+    return 0;
+}
+
+// Entry point for `or_program --server [--socket PATH] [--workers N]`.
+// Without --socket, serves a single stream on stdin/stdout and prints
+// latency percentiles to stderr at end of input.
+int run(int argc, char** argv) {
+    const char* socketPath = nullptr;
+    int workers = 1;
+    for (int i = 2; i < argc; i++) {
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            socketPath = argv[++i];
+        } else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            workers = max(1, atoi(argv[++i]));
+        } else {
+            cerr << "Usage: " << argv[0] << " --server [--socket PATH] [--workers N]\n";
+            return 1;
+        }
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+    if (socketPath) return serveSocket(socketPath, workers);
+
+    LatencyLog latencies;
+    Worker worker(latencies);
+    worker.serve(STDIN_FILENO, STDOUT_FILENO);
+    printStats(worker);
+    return 0;
+}
+
+}
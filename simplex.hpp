@@ -1,6 +1,8 @@
 #pragma once
 #include <iostream>
 #include <vector>
+#include <array>
+#include <type_traits>
 #include <iomanip>
 #include <limits>
 
@@ -37,85 +39,230 @@ void printTable(const vector<vector<double>>& table, const vector<string>& basis
     cout << endl;
 }
 
-int findPivotColumn(const vector<vector<double>>& table) {
-    size_t lastRow = table.size() - 1;
-    int pivotCol = -1;
-    double minVal = 0;
-    for (size_t j = 0; j < table[0].size() - 1; j++) {
-        if (table[lastRow][j] < minVal) {
-            minVal = table[lastRow][j];
-            pivotCol = static_cast<int>(j);
+bool isFeasible(const vector<vector<double>>& table) {
+    for (size_t i = 0; i < table.size() - 1; i++) {
+        if (table[i].back() < -1e-6) {
+            return false;
         }
     }
-    return pivotCol;
+    return true;
 }
 
-int findPivotRow(const vector<vector<double>>& table, int pivotCol) {
-    double minRatio = numeric_limits<double>::max();
-    int pivotRow = -1;
-    for (size_t i = 0; i < table.size() - 1; i++) {
-        if (table[i][pivotCol] > 0) {
-            double ratio = table[i].back() / table[i][pivotCol];
-            if (ratio < minRatio) {
-                minRatio = ratio;
-                pivotRow = static_cast<int>(i);
-            }
-        }
+enum class Status { Optimal, Unbounded, Infeasible, IterationLimit };
+
+// Reduced costs above -EPS count as optimal and column entries below EPS are
+// skipped in ratio tests, so round-off cannot pick an entering column or a
+// near-zero pivot. Sensitivity uses the same tolerance.
+const double EPS = 1e-9;
+
+// Normalises the pivot row and eliminates the pivot column from every other
+// row, objective row included. Rows and Cols are size_t or integral_constants,
+// as in solveTableImpl.
+template <typename Rows, typename Cols>
+void pivot(double* table, Rows rows, Cols cols, int* basis, size_t pivotRow, size_t pivotCol) {
+    double* pr = table + pivotRow * cols;
+    double element = pr[pivotCol];
+    for (size_t j = 0; j < cols; j++) pr[j] /= element;
+
+    for (size_t i = 0; i < rows; i++) {
+        if (i == pivotRow) continue;
+        double* row = table + i * cols;
+        double factor = row[pivotCol];
+        if (factor == 0) continue;
+        for (size_t j = 0; j < cols; j++) row[j] -= factor * pr[j];
     }
-    return pivotRow;
+    basis[pivotRow] = static_cast<int>(pivotCol);
 }
 
-void performSimplex(vector<vector<double>>& table) {
-    size_t numRows = table.size();
-    size_t numCols = table[0].size();
-    size_t numVars = numCols - numRows - 1;
-
-    vector<string> basis(numRows - 1);
-    for (size_t i = 0; i < basis.size(); i++) {
-        basis[i] = "s" + to_string(i + 1); // Initial basis is slack variables
+// Pivot loop shared by solveTable and solveFixed. Rows and Cols are size_t
+// for runtime shapes or integral_constants when the shape is known at compile
+// time, in which case every loop bound below is a constant the compiler can
+// unroll. onIteration() runs before each pivot is chosen; performSimplex uses
+// it to print the tableau, batch callers pass a no-op.
+template <typename Rows, typename Cols, typename OnIteration>
+Status solveTableImpl(double* table, Rows rows, Cols cols, int* basis, size_t maxIterations,
+                      OnIteration onIteration) {
+    size_t lastRow = rows - 1;
+    for (size_t i = 0; i < lastRow; i++) {
+        basis[i] = static_cast<int>(cols - rows + i);
     }
 
-    while (true) {
-        printTable(table, basis);
+    size_t iter = 0;
 
-        int pivotCol = findPivotColumn(table);
-        if (pivotCol == -1) break;
+    // Phase 1: a negative RHS means the slack basis is infeasible. Pick such a
+    // row and run a simplex on "maximise its basic variable": enter a column
+    // with a negative entry in that row and step no further than the rows that
+    // are already feasible allow, so feasible rows stay feasible. Bland's rule
+    // (lowest index) keeps this from cycling. A negative row with no negative
+    // entry proves the LP infeasible, since its left side cannot drop below
+    // zero. The objective row is pivoted along so it is priced out for phase 2.
+    int badRow = -1;
+    for (; iter < maxIterations; iter++) {
+        if (badRow == -1 || table[badRow * cols + cols - 1] >= -1e-6) {
+            badRow = -1;
+            for (size_t i = 0; i < lastRow; i++) {
+                if (table[i * cols + cols - 1] < -1e-6) {
+                    badRow = static_cast<int>(i);
+                    break;
+                }
+            }
+            if (badRow == -1) break;
+        }
+        onIteration();
 
-        int pivotRow = findPivotRow(table, pivotCol);
-        if (pivotRow == -1) {
-            cout << "Unbounded solution\n";
-            return;
+        const double* br = table + badRow * cols;
+        int pivotCol = -1;
+        for (size_t j = 0; j < cols - 1; j++) {
+            if (br[j] < -EPS) {
+                pivotCol = static_cast<int>(j);
+                break;
+            }
         }
+        if (pivotCol == -1) return Status::Infeasible;
 
-        basis[pivotRow] = "x" + to_string(pivotCol + 1); // Update basis
+        int pivotRow = badRow;
+        double minRatio = br[cols - 1] / br[pivotCol];
+        for (size_t i = 0; i < lastRow; i++) {
+            double a = table[i * cols + pivotCol];
+            double b = table[i * cols + cols - 1];
+            if (b < -1e-6 || a <= EPS) continue;
+            double ratio = max(b, 0.0) / a;
+            if (ratio < minRatio || (ratio == minRatio && pivotRow != badRow && basis[i] < basis[pivotRow])) {
+                minRatio = ratio;
+                pivotRow = static_cast<int>(i);
+            }
+        }
+        pivot(table, rows, cols, basis, pivotRow, pivotCol);
+    }
+    if (iter == maxIterations) return Status::IterationLimit;
 
-        double pivot = table[pivotRow][pivotCol];
-        for (size_t j = 0; j < numCols; j++) {
-            table[pivotRow][j] /= pivot;
+    for (; iter < maxIterations; iter++) {
+        onIteration();
+        double* z = table + lastRow * cols;
+        int pivotCol = -1;
+        double minVal = -EPS;
+        for (size_t j = 0; j < cols - 1; j++) {
+            if (z[j] < minVal) {
+                minVal = z[j];
+                pivotCol = static_cast<int>(j);
+            }
         }
+        if (pivotCol == -1) return Status::Optimal;
 
-        for (size_t i = 0; i < numRows; i++) {
-            if (static_cast<int>(i) != pivotRow) {
-                double factor = table[i][pivotCol];
-                for (size_t j = 0; j < numCols; j++) {
-                    table[i][j] -= factor * table[pivotRow][j];
+        int pivotRow = -1;
+        double minRatio = numeric_limits<double>::max();
+        for (size_t i = 0; i < lastRow; i++) {
+            double a = table[i * cols + pivotCol];
+            if (a > EPS) {
+                double ratio = table[i * cols + cols - 1] / a;
+                if (ratio < minRatio) {
+                    minRatio = ratio;
+                    pivotRow = static_cast<int>(i);
                 }
             }
         }
+        if (pivotRow == -1) return Status::Unbounded;
+
+        pivot(table, rows, cols, basis, pivotRow, pivotCol);
     }
+    return Status::IterationLimit;
+}
 
-    cout << "\nFinal Optimal Table:\n";
-    printTable(table, basis);
-    cout << "Optimal value: " << table.back().back() << endl;
+// Non-printing variant of performSimplex for batch callers. The tableau is a
+// flat row-major buffer with the same layout runSimplex builds (constraint
+// rows, then the objective row; slack columns after the decision variables).
+// basis[i] receives the column that is basic in row i.
+Status solveTable(double* table, size_t rows, size_t cols, int* basis) {
+    return solveTableImpl(table, rows, cols, basis, 50 * cols, [] {});
 }
 
-bool isFeasible(const vector<vector<double>>& table) {
-    for (size_t i = 0; i < table.size() - 1; i++) {
-        if (table[i].back() < -1e-6) {
-            return false;
+// Value of decision variable `var` in a tableau solved by solveTable.
+double basicValue(const double* table, size_t rows, size_t cols, const int* basis, int var) {
+    for (size_t i = 0; i + 1 < rows; i++) {
+        if (basis[i] == var) return table[i * cols + cols - 1];
+    }
+    return 0;
+}
+
+// solveTable for exactly M constraints and N variables. The tableau layout is
+// unchanged, so it is solved in place with every dimension a compile-time
+// constant.
+template <size_t M, size_t N>
+Status solveFixed(double* table, int* basis) {
+    constexpr size_t R = M + 1, C = N + M + 1;
+    return solveTableImpl(table, integral_constant<size_t, R>{},
+                          integral_constant<size_t, C>{}, basis, 50 * C, [] {});
+}
+
+const size_t MAX_FIXED_CONSTRAINTS = 8;
+const size_t MAX_FIXED_VARIABLES = 8;
+
+using FixedKernel = Status (*)(double*, int*);
+
+template <size_t... Ks>
+constexpr array<FixedKernel, sizeof...(Ks)> makeFixedKernels(index_sequence<Ks...>) {
+    return { &solveFixed<Ks / MAX_FIXED_VARIABLES + 1, Ks % MAX_FIXED_VARIABLES + 1>... };
+}
+
+// fixedKernels[(m - 1) * MAX_FIXED_VARIABLES + (n - 1)] solves m x n problems
+constexpr array<FixedKernel, MAX_FIXED_CONSTRAINTS * MAX_FIXED_VARIABLES> fixedKernels =
+    makeFixedKernels(make_index_sequence<MAX_FIXED_CONSTRAINTS * MAX_FIXED_VARIABLES>{});
+
+// Entry point for batch callers: routes small LPs to the fixed-size kernels
+// and everything else to solveTable.
+Status solve(double* table, size_t rows, size_t cols, int* basis) {
+    size_t m = rows - 1, n = cols - rows;
+    if (m == 0 || n == 0 || m > MAX_FIXED_CONSTRAINTS || n > MAX_FIXED_VARIABLES)
+        return solveTable(table, rows, cols, basis);
+    return fixedKernels[(m - 1) * MAX_FIXED_VARIABLES + (n - 1)](table, basis);
+}
+
+// Solves the tableau runSimplex builds with the same pivot loop as the batch
+// solvers (phase 1 for negative RHS, EPS in the pricing and ratio tests),
+// printing it before every pivot. The menu and server therefore agree on
+// every LP; table is left holding the final tableau.
+void performSimplex(vector<vector<double>>& table) {
+    size_t numRows = table.size();
+    size_t numCols = table[0].size();
+    size_t numVars = numCols - numRows;
+
+    vector<double> flat(numRows * numCols);
+    for (size_t i = 0; i < numRows; i++) {
+        for (size_t j = 0; j < numCols; j++) flat[i * numCols + j] = table[i][j];
+    }
+    vector<int> basisCols(numRows - 1);
+    vector<string> basis(numRows - 1);
+
+    auto sync = [&] {
+        for (size_t i = 0; i < numRows; i++) {
+            for (size_t j = 0; j < numCols; j++) table[i][j] = flat[i * numCols + j];
         }
+        for (size_t i = 0; i < basis.size(); i++) {
+            size_t col = static_cast<size_t>(basisCols[i]);
+            basis[i] = col < numVars ? "x" + to_string(col + 1) : "s" + to_string(col - numVars + 1);
+        }
+    };
+
+    Status status = solveTableImpl(flat.data(), numRows, numCols, basisCols.data(), 50 * numCols,
+                                   [&] { sync(); printTable(table, basis); });
+    sync();
+
+    switch (status) {
+    case Status::Optimal:
+        cout << "\nFinal Optimal Table:\n";
+        printTable(table, basis);
+        cout << "Optimal value: " << table.back().back() << endl;
+        break;
+    case Status::Unbounded:
+        cout << "Unbounded solution\n";
+        break;
+    case Status::Infeasible:
+        cout << "Infeasible solution\n";
+        break;
+    case Status::IterationLimit:
+        cout << "Iteration limit reached\n";
+        break;
     }
-    return true;
 }
 
 void runSimplex() {
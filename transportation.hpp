@@ -4,6 +4,7 @@
 #include <iomanip>
 #include <limits>
 #include <algorithm>
+#include "workspace.hpp"
 
 using namespace std;
 
@@ -53,89 +54,102 @@ double calculateTotalCost(const vector<vector<double>>& allocation,
     return total;
 }
 
-// Vogel's Approximation Method
-vector<vector<double>> vogelApproximation(vector<vector<double>> cost,
-                                          vector<double> supply,
-                                          vector<double> demand) {
-    size_t m = supply.size();
-    size_t n = demand.size();
-    vector<vector<double>> allocation(m, vector<double>(n, 0));
-    vector<bool> rowDone(m, false);
-    vector<bool> colDone(n, false);
-
-    while (true) {
-        if (all_of(rowDone.begin(), rowDone.end(), [](bool v) { return v; }) &&
-            all_of(colDone.begin(), colDone.end(), [](bool v) { return v; })) {
-            break;
-        }
-
-        // Calculate penalties
-        vector<pair<double, int>> rowPenalty(m, { -1, -1 });
-        vector<pair<double, int>> colPenalty(n, { -1, -1 });
+// Vogel's Approximation over flat row-major buffers with scratch from the
+// arena. supply and demand are consumed; allocation (m x n) is overwritten.
+// Penalties are the gap between the two cheapest open cells, found in one
+// pass instead of sorting; ties go to the highest index, as max_element over
+// (penalty, index) pairs would pick.
+void vogelApproximation(const double* cost, double* supply, double* demand,
+                        size_t m, size_t n, Workspace::Arena& arena,
+                        double* allocation) {
+    bool* rowDone = arena.allocFilled<bool>(m, false);
+    bool* colDone = arena.allocFilled<bool>(n, false);
+    for (size_t k = 0; k < m * n; k++) allocation[k] = 0;
+    size_t rowsLeft = m, colsLeft = n;
+
+    while (rowsLeft > 0 || colsLeft > 0) {
+        double bestRow = -1, bestCol = -1;
+        int maxRow = -1, maxCol = -1;
 
         for (size_t i = 0; i < m; i++) {
             if (rowDone[i]) continue;
-            vector<double> temp;
+            double lo = numeric_limits<double>::max(), hi = lo;
+            size_t open = 0;
             for (size_t j = 0; j < n; j++) {
-                if (!colDone[j]) temp.push_back(cost[i][j]);
-            }
-            if (temp.size() >= 2) {
-                sort(temp.begin(), temp.end());
-                rowPenalty[i] = { temp[1] - temp[0], i };
-            } else if (temp.size() == 1) {
-                rowPenalty[i] = { temp[0], i };
+                if (colDone[j]) continue;
+                double c = cost[i * n + j];
+                if (c < lo) { hi = lo; lo = c; } else if (c < hi) { hi = c; }
+                open++;
             }
+            double penalty = open >= 2 ? hi - lo : open == 1 ? lo : -1;
+            if (penalty >= bestRow) { bestRow = penalty; maxRow = static_cast<int>(i); }
         }
 
         for (size_t j = 0; j < n; j++) {
             if (colDone[j]) continue;
-            vector<double> temp;
+            double lo = numeric_limits<double>::max(), hi = lo;
+            size_t open = 0;
             for (size_t i = 0; i < m; i++) {
-                if (!rowDone[i]) temp.push_back(cost[i][j]);
-            }
-            if (temp.size() >= 2) {
-                sort(temp.begin(), temp.end());
-                colPenalty[j] = { temp[1] - temp[0], j };
-            } else if (temp.size() == 1) {
-                colPenalty[j] = { temp[0], j };
+                if (rowDone[i]) continue;
+                double c = cost[i * n + j];
+                if (c < lo) { hi = lo; lo = c; } else if (c < hi) { hi = c; }
+                open++;
             }
+            double penalty = open >= 2 ? hi - lo : open == 1 ? lo : -1;
+            if (penalty >= bestCol) { bestCol = penalty; maxCol = static_cast<int>(j); }
         }
 
-        // Choose max penalty
-        pair<double, int> maxRow = *max_element(rowPenalty.begin(), rowPenalty.end());
-        pair<double, int> maxCol = *max_element(colPenalty.begin(), colPenalty.end());
-
         int selectedRow = -1, selectedCol = -1;
-        if (maxRow.first > maxCol.first) {
-            selectedRow = maxRow.second;
+        if (bestRow > bestCol) {
+            selectedRow = maxRow;
             double minVal = numeric_limits<double>::max();
             for (size_t j = 0; j < n; j++) {
-                if (!colDone[j] && cost[selectedRow][j] < minVal) {
-                    minVal = cost[selectedRow][j];
-                    selectedCol = j;
+                if (!colDone[j] && cost[selectedRow * n + j] < minVal) {
+                    minVal = cost[selectedRow * n + j];
+                    selectedCol = static_cast<int>(j);
                 }
             }
-        } else {
-            selectedCol = maxCol.second;
+        } else if (maxCol != -1) {
+            selectedCol = maxCol;
             double minVal = numeric_limits<double>::max();
             for (size_t i = 0; i < m; i++) {
-                if (!rowDone[i] && cost[i][selectedCol] < minVal) {
-                    minVal = cost[i][selectedCol];
-                    selectedRow = i;
+                if (!rowDone[i] && cost[i * n + selectedCol] < minVal) {
+                    minVal = cost[i * n + selectedCol];
+                    selectedRow = static_cast<int>(i);
                 }
             }
         }
+        if (selectedRow == -1 || selectedCol == -1) break; // Nothing left to pair
 
-        // Allocate
         double qty = min(supply[selectedRow], demand[selectedCol]);
-        allocation[selectedRow][selectedCol] = qty;
+        allocation[selectedRow * n + selectedCol] = qty;
         supply[selectedRow] -= qty;
         demand[selectedCol] -= qty;
 
-        if (supply[selectedRow] == 0) rowDone[selectedRow] = true;
-        if (demand[selectedCol] == 0) colDone[selectedCol] = true;
+        if (supply[selectedRow] == 0) { rowDone[selectedRow] = true; rowsLeft--; }
+        if (demand[selectedCol] == 0) { colDone[selectedCol] = true; colsLeft--; }
+    }
+}
+
+// Vogel's Approximation Method
+vector<vector<double>> vogelApproximation(vector<vector<double>> cost,
+                                          vector<double> supply,
+                                          vector<double> demand) {
+    size_t m = supply.size();
+    size_t n = demand.size();
+    vector<double> flatCost(m * n), flatAllocation(m * n);
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) flatCost[i * n + j] = cost[i][j];
     }
 
+    Workspace::Arena arena((m + n) * sizeof(bool) + 64);
+    vogelApproximation(flatCost.data(), supply.data(), demand.data(), m, n, arena,
+                       flatAllocation.data());
+
+    vector<vector<double>> allocation(m, vector<double>(n));
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) allocation[i][j] = flatAllocation[i * n + j];
+    }
     return allocation;
 }
 
@@ -0,0 +1,100 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+using namespace std;
+
+namespace Workspace {
+
+// Monotonic bump allocator. Memory handed out by alloc() stays valid until the
+// next reset(); reset() rewinds the offset instead of freeing, so once the
+// arena has grown to fit the largest problem seen, later solves never call malloc.
+class Arena {
+public:
+    explicit Arena(size_t initialBytes = 1 << 16) {
+        capacity = initialBytes;
+        base = static_cast<unsigned char*>(malloc(capacity));
+        if (!base) throw bad_alloc();
+    }
+
+    ~Arena() {
+        free(base);
+        releaseOverflow();
+    }
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    template <typename T>
+    T* alloc(size_t count) {
+        size_t bytes = count * sizeof(T);
+        size_t start = (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (start + bytes <= capacity) {
+            offset = start + bytes;
+            used = offset > used ? offset : used;
+            return reinterpret_cast<T*>(base + start);
+        }
+        // Out of room: serve this request from a side block and remember how
+        // much we needed so reset() can grow the main block once.
+        Overflow* block = static_cast<Overflow*>(malloc(sizeof(Overflow) + bytes + alignof(max_align_t)));
+        if (!block) throw bad_alloc();
+        block->next = overflow;
+        overflow = block;
+        overflowBytes += bytes + alignof(T);
+        unsigned char* raw = reinterpret_cast<unsigned char*>(block + 1);
+        size_t addr = reinterpret_cast<size_t>(raw);
+        return reinterpret_cast<T*>(raw + ((alignof(T) - addr % alignof(T)) % alignof(T)));
+    }
+
+    template <typename T>
+    T* allocFilled(size_t count, const T& value) {
+        T* p = alloc<T>(count);
+        for (size_t i = 0; i < count; i++) p[i] = value;
+        return p;
+    }
+
+    // Rewind for the next solve. If the last solve overflowed, replace the
+    // main block with one large enough for it.
+    void reset() {
+        if (overflow) {
+            size_t needed = used + overflowBytes;
+            releaseOverflow();
+            size_t grown = capacity;
+            while (grown < needed) grown *= 2;
+            unsigned char* bigger = static_cast<unsigned char*>(malloc(grown));
+            if (!bigger) throw bad_alloc();
+            free(base);
+            base = bigger;
+            capacity = grown;
+        }
+        offset = 0;
+        used = 0;
+    }
+
+    size_t bytesReserved() const { return capacity; }
+
+private:
+    struct Overflow {
+        Overflow* next;
+    };
+
+    void releaseOverflow() {
+        while (overflow) {
+            Overflow* next = overflow->next;
+            free(overflow);
+            overflow = next;
+        }
+        overflowBytes = 0;
+    }
+
+    unsigned char* base = nullptr;
+    size_t capacity = 0;
+    size_t offset = 0;
+    size_t used = 0;
+    Overflow* overflow = nullptr;
+    size_t overflowBytes = 0;
+};
+
+}